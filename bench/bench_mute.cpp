@@ -0,0 +1,235 @@
+// bench_mute.cpp
+//
+// Self-benchmark of the mute framework hot paths. Each scenario below is a
+// synthetic suite exercising one aspect of the framework; the number and kind
+// of operations each scenario performs are listed in `workloads`, computed from
+// the same constants that size the scenarios. Each scenario is run through the
+// text reporter against a null output and a buffered output, and through a
+// counting reporter that performs no formatting at all. The results are written
+// as JSON to the file given on the command line.
+
+#include "mute/mute.h"
+
+#include <time.h>
+
+// =============================================================================
+// Synthetic suites
+// =============================================================================
+
+static const int check_count        = 1000000;
+static const int failed_check_count = 100000;
+static const int wide_tree_width    = 1000;
+static const int deep_tree_depth    = 12;
+
+// tree() generates a tree of sections `depth` levels deep, with `width`
+// sibling sections at each level.
+static void tree( mute::test_env_t& __test_env, int depth, int width ) {
+    if ( depth == 0 ) {
+        return;
+    }
+    for ( int i = 0; i < width; i++ ) {
+        SECTION( "node" ) {
+            tree( __test_env, depth - 1, width );
+        }
+    }
+}
+
+SCENARIO( "passing checks", "" ) {
+    using namespace mute;
+    for ( int i = 0; i < check_count; i++ ) {
+        CHECK_THAT( i, ge( 0 ) );
+    }
+}
+
+SCENARIO( "failing checks", "" ) {
+    using namespace mute;
+    for ( int i = 0; i < failed_check_count; i++ ) {
+        CHECK_THAT( i, lt( 0 ) );
+    }
+}
+
+SCENARIO( "wide section tree", "" ) {
+    tree( __test_env, 1, wide_tree_width );
+}
+
+SCENARIO( "deep section tree", "" ) {
+    tree( __test_env, deep_tree_depth, 2 );
+}
+
+// workload_t describes the operations performed by one of the scenarios
+// above, to report per operation timings.
+struct workload_t {
+    const char* name;
+    const char* unit;
+    long        ops;
+};
+
+// The deep tree has 2^depth leaves, each reached through `depth` sections.
+static const workload_t workloads[] = {
+    { "passing checks", "check", check_count },
+    { "failing checks", "check", failed_check_count },
+    { "wide section tree", "leaf", wide_tree_width },
+    { "deep section tree", "section", long( deep_tree_depth ) << deep_tree_depth },
+};
+
+// find_workload returns the workload entry matching a test by name, or
+// nullptr if the test is not listed.
+static const workload_t* find_workload( const mute::test_t& test ) {
+    for ( const workload_t& w : workloads ) {
+        if ( strcmp( w.name, test.name() ) == 0 ) {
+            return &w;
+        }
+    }
+    return nullptr;
+}
+
+// =============================================================================
+// Outputs and reporters
+// =============================================================================
+
+struct null_output_t : mute::output_t {
+    virtual void write( const char* b, size_t l ) {
+    }
+};
+
+// buffered_output_t accumulates output into a fixed size buffer, discarded
+// when full, and keeps track of the number of bytes and events written.
+struct buffered_output_t : mute::output_t {
+    virtual void write( const char* b, size_t l ) {
+        if ( _length + l > sizeof( _buffer ) ) {
+            flush();
+        }
+        if ( l > sizeof( _buffer ) ) {
+            count( b, l );
+            return;
+        }
+        memcpy( _buffer + _length, b, l );
+        _length += l;
+    }
+
+    void flush() {
+        count( _buffer, _length );
+        _length = 0;
+    }
+
+    void count( const char* b, size_t l ) {
+        bytes += l;
+        for ( const char* p = b; ( p = (const char*)memchr( p, '\n', b + l - p ) ); p++ ) {
+            events++;
+        }
+    }
+
+    uint64_t bytes  = 0;
+    uint64_t events = 0;
+
+private:
+    char   _buffer[64 * 1024];
+    size_t _length = 0;
+};
+
+// counting_reporter_t only counts check results, without formatting them.
+struct counting_reporter_t : mute::reporter_t {
+    virtual void check_result(
+        const char* filename, int lineno, const char* expr, bool success,
+        const mute::description_t& description ) {
+        if ( success ) {
+            passed++;
+        } else {
+            failed++;
+        }
+    }
+
+    uint64_t passed = 0;
+    uint64_t failed = 0;
+};
+
+// =============================================================================
+// Benchmark driver
+// =============================================================================
+
+static const int run_count = 3;
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return uint64_t( ts.tv_sec ) * 1000000000 + ts.tv_nsec;
+}
+
+// measure runs a test `run_count` times and returns the fastest run duration
+// in nanoseconds.
+static uint64_t measure( const mute::test_t& test, mute::reporter_t& reporter ) {
+    uint64_t best = UINT64_MAX;
+    for ( int i = 0; i < run_count; i++ ) {
+        mute::test_env_t env( reporter );
+        uint64_t         start = now_ns();
+        mute::run_test( env, test );
+        uint64_t elapsed = now_ns() - start;
+        if ( elapsed < best ) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+static void report(
+    FILE* f, bool first, const mute::test_t& test, const char* output,
+    uint64_t ns, uint64_t bytes, uint64_t events ) {
+    const workload_t* workload = find_workload( test );
+    const char*       unit     = workload ? workload->unit : "run";
+    long              ops      = workload ? workload->ops : 1;
+
+    fprintf(
+        f,
+        "%s\n    {\"name\": \"%s\", \"output\": \"%s\", \"unit\": \"%s\", "
+        "\"ops\": %ld, \"ns\": %" PRIu64 ", \"ns_per_op\": %.2f, "
+        "\"ops_per_sec\": %.0f",
+        first ? "" : ",", test.name(), output, unit, ops, ns,
+        double( ns ) / ops, ops * 1e9 / ns );
+    if ( events ) {
+        fprintf(
+            f,
+            ", \"bytes\": %" PRIu64 ", \"events\": %" PRIu64
+            ", \"bytes_per_event\": %.2f",
+            bytes, events, double( bytes ) / events );
+    }
+    fprintf( f, "}" );
+
+    printf(
+        "%-20s %-8s %10.2f ns/%s\n", test.name(), output, double( ns ) / ops,
+        unit );
+}
+
+int main( int argc, char* argv[] ) {
+    const char* path = argc > 1 ? argv[1] : "bench.json";
+    FILE*       f    = fopen( path, "w" );
+    if ( !f ) {
+        fprintf( stderr, "cannot open %s\n", path );
+        return 1;
+    }
+
+    fprintf( f, "{\"mute_version\": \"%s\", \"results\": [", MUTE_VERSION );
+    bool first = true;
+    auto tests = mute::test_registry_t::instance().test_list();
+    for ( auto it = tests.begin(); it != tests.end(); it++ ) {
+        counting_reporter_t counting_reporter;
+        uint64_t            ns = measure( *it, counting_reporter );
+        report( f, first, *it, "counting", ns, 0, 0 );
+        first = false;
+
+        null_output_t         null_output;
+        mute::text_reporter_t null_reporter( null_output );
+        ns = measure( *it, null_reporter );
+        report( f, false, *it, "null", ns, 0, 0 );
+
+        buffered_output_t     buffered_output;
+        mute::text_reporter_t buffered_reporter( buffered_output );
+        ns = measure( *it, buffered_reporter );
+        buffered_output.flush();
+        report(
+            f, false, *it, "buffered", ns, buffered_output.bytes / run_count,
+            buffered_output.events / run_count );
+    }
+    fprintf( f, "\n]}\n" );
+    fclose( f );
+    return 0;
+}
@@ -43,13 +43,25 @@
 #pragma once
 #include <inttypes.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __cplusplus
+#include <new>
+#endif
+
 #define MUTE_VERSION "v0.1.0"
 
+// Size in bytes of the scratch arena available to tests, see scratch_arena_t.
+// The arena is opt-in: with the default size of 0, it is never touched by the
+// framework and every allocation fails.
+#ifndef MUTE_SCRATCH_SIZE
+#define MUTE_SCRATCH_SIZE 0
+#endif
+
 #define MUTE_PP_CAT( x, y ) __MUTE_PP_CAT( x, y )
 #define __MUTE_PP_CAT( x, y ) x##y
 
@@ -119,6 +131,14 @@ struct writer_t {
         write_newline();
     }
 
+    void timeout( const char* filename, int lineno, const char* prefix, const char* name ) {
+        write_prefix( filename, lineno );
+        write( "timeout: ", 9 );
+        write_cstr( prefix );
+        write_cstr( name );
+        write_newline();
+    }
+
     void report_prefix( const char* filename, int lineno, bool success ) {
         write_prefix( filename, lineno );
         if ( success ) {
@@ -252,23 +272,211 @@ void write_description( output_t& out, const void* v ) {
 } // namespace mute
 
 // =============================================================================
-// Definition of main mute test framework classes, including test_env_t,
-// section_t, test_t and test_registry_t
+// Definition of reporter_t interface, receiving structured test events
 // =============================================================================
 
 namespace mute {
 
 struct mute_t {};
+struct test_t;
+struct fixture_t;
+
+// location_t identifies a test or section, as reported in enter / leave
+// events.
+struct location_t {
+    const char* filename;
+    int         lineno;
+    const char* prefix;
+    const char* name;
+};
+
+// description_t is a thunk provided along with each check result, allowing a
+// reporter to format the checked expression and the details of a failure on
+// demand. It is only valid for the duration of the check_result() call.
+struct description_t {
+    virtual void describe( output_t& out ) const      = 0;
+    virtual void write_details( output_t& out ) const = 0;
+};
+
+// reporter_t receives the events generated while running tests. Test events
+// are generated for each run of a test, which happens once for each leaf
+// section of the test. All callbacks default to doing nothing.
+struct reporter_t {
+    virtual void test_begin( const test_t& test ) {
+    }
+    virtual void test_end( const test_t& test ) {
+    }
+    virtual void section_enter( const location_t& section ) {
+    }
+    virtual void section_leave( const location_t& section ) {
+    }
+    virtual void check_result(
+        const char* filename, int lineno, const char* expr, bool success,
+        const description_t& description ) {
+    }
+    virtual void section_timeout( const location_t& section ) {
+    }
+    virtual void test_timeout( const test_t& test ) {
+    }
+    virtual void scratch_peak( const test_t& test, size_t peak ) {
+    }
+    virtual void fixture_setup_begin( const fixture_t& fixture ) {
+    }
+    virtual void fixture_setup_end( const fixture_t& fixture ) {
+    }
+    virtual void fixture_teardown( const fixture_t& fixture ) {
+    }
+};
+
+} // namespace mute
+
+// =============================================================================
+// Definition of scratch_arena_t and scratch_allocator_t, providing temporary
+// memory to tests without heap allocation
+// =============================================================================
+
+namespace mute {
+
+// scratch_arena_t is a bump allocator over a fixed size region. The test
+// framework resets it before running each leaf section, and releases any
+// memory allocated within a section when leaving that section. It keeps
+// track of the peak memory use, reported at the end of each leaf. It is
+// implemented as a dummy template type to ensure correct sharing of the
+// class static instance.
+template <typename T>
+struct scratch_arena_tt {
+    static scratch_arena_tt& instance() {
+        static scratch_arena_tt _instance;
+        return _instance;
+    }
+
+    // allocate() returns `size` bytes aligned on `align`, or nullptr if
+    // the arena is exhausted or if `align` is not a power of two.
+    void* allocate( size_t size, size_t align = alignof( ::max_align_t ) ) {
+        if ( align == 0 || ( align & ( align - 1 ) ) != 0 ) {
+            return nullptr;
+        }
+        size_t offset = ( _used + align - 1 ) & ~( align - 1 );
+        if ( offset > capacity() || size > capacity() - offset ) {
+            return nullptr;
+        }
+        _used = offset + size;
+        if ( _used > _peak ) {
+            _peak = _used;
+        }
+        return _buffer + offset;
+    }
+
+    template <typename value_t>
+    value_t* allocate_array( size_t count ) {
+        if ( count > capacity() / sizeof( value_t ) ) {
+            return nullptr;
+        }
+        return (value_t*)allocate( count * sizeof( value_t ), alignof( value_t ) );
+    }
+
+    size_t mark() const {
+        return _used;
+    }
+
+    void release( size_t mark ) {
+        _used = mark;
+    }
+
+    void reset() {
+        _used = 0;
+        _peak = 0;
+    }
+
+    size_t used() const {
+        return _used;
+    }
+    size_t peak() const {
+        return _peak;
+    }
+    static size_t capacity() {
+        return MUTE_SCRATCH_SIZE;
+    }
+
+private:
+    scratch_arena_tt() {
+    }
+
+    size_t _used = 0;
+    size_t _peak = 0;
+
+    alignas( ::max_align_t ) char _buffer[MUTE_SCRATCH_SIZE > 0 ? MUTE_SCRATCH_SIZE : 1];
+};
+typedef scratch_arena_tt<mute_t> scratch_arena_t;
+
+static inline scratch_arena_t& scratch() {
+    return scratch_arena_t::instance();
+}
+
+// scratch_allocator_t<value_t> is an STL-compatible allocator allocating from
+// the scratch arena. Deallocation is a no-op, memory is released by the test
+// framework. As the framework does not use exceptions, running out of scratch
+// memory aborts the test binary.
+template <typename value_t>
+struct scratch_allocator_t {
+    typedef value_t value_type;
+
+    scratch_allocator_t() {
+    }
+    template <typename other_t>
+    scratch_allocator_t( const scratch_allocator_t<other_t>& ) {
+    }
+
+    value_t* allocate( size_t count ) {
+        value_t* p = scratch().allocate_array<value_t>( count );
+        if ( !p ) {
+            fprintf( stderr, "mute: scratch arena exhausted\n" );
+            abort();
+        }
+        return p;
+    }
+
+    void deallocate( value_t* p, size_t count ) {
+    }
+
+    template <typename other_t>
+    bool operator==( const scratch_allocator_t<other_t>& ) const {
+        return true;
+    }
+    template <typename other_t>
+    bool operator!=( const scratch_allocator_t<other_t>& ) const {
+        return false;
+    }
+};
+
+} // namespace mute
+
+// =============================================================================
+// Definition of main mute test framework classes, including test_env_t,
+// section_t, test_t and test_registry_t
+// =============================================================================
+
+namespace mute {
 
 // test_env_t encapsulates the context in which tests are run, including
-// the output to report to, the sections being visited, and the abort status
+// the reporter to report to, the sections being visited, and the abort status
 // for the current test.
 struct test_env_t {
-    test_env_t( output_t& output ) : output( output ) {
+    test_env_t( reporter_t& reporter ) : reporter( reporter ) {
     }
-    output_t& output;
-
-    bool enter_section() {
+    reporter_t&   reporter;
+    const test_t* test = nullptr;
+
+    // Input bytes provided by the runner to tests tagged with `fuzz`,
+    // accessible from the test body through FUZZ_DATA and FUZZ_SIZE.
+    const uint8_t* input_data = nullptr;
+    size_t         input_size = 0;
+
+    bool enter_section( const location_t& location ) {
+        _sections[_depth] = location;
+#if MUTE_SCRATCH_SIZE > 0
+        _scratch_marks[_depth] = scratch().mark();
+#endif
         _index[_depth]++;
         _count[_depth]++;
         bool enter = ( _index[_depth] == _count[_depth] );
@@ -279,12 +487,21 @@ struct test_env_t {
     void leave_section() {
         _depth--;
         _index[_depth]--;
+#if MUTE_SCRATCH_SIZE > 0
+        scratch().release( _scratch_marks[_depth] );
+#endif
     }
 
     int depth() {
         return _depth;
     }
 
+    // section() returns the location of the section currently entered at
+    // the given depth, with 0 being the outermost section.
+    const location_t& section( int depth ) {
+        return _sections[depth];
+    }
+
     void reset() {
         _tracking = false;
         for ( int i = 0; i < max_depth; i++ ) {
@@ -294,6 +511,10 @@ struct test_env_t {
     }
 
     bool repeat() {
+#if MUTE_SCRATCH_SIZE > 0
+        scratch().reset();
+#endif
+        _rewound = false;
         if ( !_tracking ) {
             reset();
             _tracking = true;
@@ -322,6 +543,38 @@ struct test_env_t {
         return false;
     }
 
+    // unwind() restores the traversal state after a leaf run was abandoned
+    // without leaving its sections, e.g. upon timeout. If the run followed a
+    // rewind(), the sections it did not reach are known from the previous run.
+    // Otherwise, each entered section is assumed to have a next sibling, so
+    // that the next repeat() looks for it rather than ending the test.
+    void unwind() {
+        int depth = _depth;
+        while ( _depth > 0 ) {
+            leave_section();
+        }
+        for ( int i = 0; i < max_depth; i++ ) {
+            if ( _rewound ) {
+                _count[i] = _rewound_count[i];
+            } else if ( i < depth && _count[i] < _index[i] + 2 ) {
+                _count[i] = _index[i] + 2;
+            }
+        }
+    }
+
+    // rewind() prepares the environment for running the same leaf section
+    // again, rather than moving on to the next one on the next repeat().
+    void rewind() {
+        for ( int i = 0; i < max_depth; i++ ) {
+            _rewound_count[i] = _count[i];
+            _count[i]         = 0;
+        }
+        _rewound = true;
+#if MUTE_SCRATCH_SIZE > 0
+        scratch().reset();
+#endif
+    }
+
     static const int max_depth = 16;
 
 private:
@@ -329,26 +582,30 @@ private:
     int  _depth            = 0;
     int  _index[max_depth] = {0};
     int  _count[max_depth] = {0};
+
+    bool _rewound                  = false;
+    int  _rewound_count[max_depth] = {0};
+
+    location_t _sections[max_depth];
+#if MUTE_SCRATCH_SIZE > 0
+    size_t _scratch_marks[max_depth];
+#endif
 };
 
 // section_t represent an exclusive branch within a test case
 struct section_t {
     section_t( test_env_t& __test_env, const char* filename, int lineno, const char* prefix, const char* name )
-        : _test_env( __test_env ),
-          _filename( filename ),
-          _lineno( lineno ),
-          _prefix( prefix ),
-          _name( name ) {
+        : _test_env( __test_env ), _location{filename, lineno, prefix, name} {
         //
-        _enter = _test_env.enter_section();
+        _enter = _test_env.enter_section( _location );
         if ( _enter ) {
-            writer( _test_env.output ).enter( _filename, _lineno, _prefix, _name );
+            _test_env.reporter.section_enter( _location );
         }
     }
 
     ~section_t() {
         if ( _enter ) {
-            writer( _test_env.output ).leave( _filename, _lineno, _prefix, _name );
+            _test_env.reporter.section_leave( _location );
         }
         _test_env.leave_section();
     }
@@ -363,10 +620,7 @@ struct section_t {
 
 private:
     test_env_t& _test_env;
-    const char* _filename;
-    int         _lineno;
-    const char* _prefix;
-    const char* _name;
+    location_t  _location;
 
     bool _enter = false;
     bool _done  = false;
@@ -505,17 +759,324 @@ const test_t* register_test() {
     return &registrar;
 }
 
+// find_flag looks for a tag within a test flags string such as
+// "[aaa,bbb,timeout=5]". Tags are separated by brackets, commas or spaces and
+// can carry a value after an '=' sign. It returns a pointer to the value of
+// the tag, or to an empty value for a plain tag, and stores the length of the
+// value in `length`. It returns nullptr if the tag is not present.
+static inline const char* find_flag( const char* flags, const char* name, size_t* length = nullptr ) {
+    const char* separators = "[], \t";
+    size_t      name_len   = strlen( name );
+    const char* p          = flags;
+    while ( p && *p ) {
+        p += strspn( p, separators );
+        size_t tag_len = strcspn( p, separators );
+        if ( tag_len >= name_len && strncmp( p, name, name_len ) == 0 ) {
+            if ( tag_len == name_len ) {
+                if ( length ) {
+                    *length = 0;
+                }
+                return p + tag_len;
+            }
+            if ( p[name_len] == '=' ) {
+                if ( length ) {
+                    *length = tag_len - name_len - 1;
+                }
+                return p + name_len + 1;
+            }
+        }
+        p += tag_len;
+    }
+    return nullptr;
+}
+
+static inline bool has_flag( const char* flags, const char* name ) {
+    return find_flag( flags, name ) != nullptr;
+}
+
+// fixture_t is the base class of suite fixtures, shared by all the tests
+// naming them with a `fixture=<name>` tag in their flags. A fixture is built
+// lazily before running the first test that uses it, and torn down after the
+// last registered test using it.
+struct fixture_t {
+    virtual const char* name() const     = 0;
+    virtual const char* filename() const = 0;
+    virtual int         lineno() const   = 0;
+    virtual void        build()          = 0;
+    virtual void        destroy()        = 0;
+
+    bool built() const {
+        return _built;
+    }
+
+    bool       _built = false;
+    fixture_t* _next  = nullptr;
+    fixture_t* next() {
+        return _next;
+    }
+};
+
+// fixture_registry_t maintains the master list of suite fixtures. It is
+// implemented as a dummy template type to ensure correct sharing of class
+// static variables.
+template <typename T>
+struct fixture_registry_tt {
+    typedef list_t<fixture_t> fixture_list_t;
+
+    static fixture_registry_tt& instance() {
+        static fixture_registry_tt _instance;
+        return _instance;
+    }
+
+    void register_fixture( fixture_t* fixture ) {
+        if ( _last_fixture )
+            _last_fixture->_next = fixture;
+        else
+            _first_fixture = fixture;
+
+        fixture->_next = nullptr;
+        _last_fixture  = fixture;
+    }
+
+    fixture_list_t fixture_list() const {
+        return fixture_list_t( _first_fixture );
+    }
+
+private:
+    fixture_registry_tt() : _first_fixture( nullptr ), _last_fixture( nullptr ) {
+    }
+
+    fixture_t* _first_fixture;
+    fixture_t* _last_fixture;
+};
+typedef fixture_registry_tt<mute_t> fixture_registry_t;
+
+// fixture_tt<value_t> is a suite fixture holding a value_t, constructed in
+// place when the fixture is built, without heap allocation.
+template <typename value_t>
+struct fixture_tt : fixture_t {
+    fixture_tt( const char* name, const char* filename, int lineno )
+        : _name( name ), _filename( filename ), _lineno( lineno ) {
+        fixture_registry_t::instance().register_fixture( this );
+    }
+
+    virtual const char* name() const {
+        return _name;
+    }
+    virtual const char* filename() const {
+        return _filename;
+    }
+    virtual int lineno() const {
+        return _lineno;
+    }
+    virtual void build() {
+        new ( _storage ) value_t();
+    }
+    virtual void destroy() {
+        value().~value_t();
+    }
+
+    const value_t& value() const {
+        return *reinterpret_cast<const value_t*>( _storage );
+    }
+
+private:
+    const char* _name;
+    const char* _filename;
+    int         _lineno;
+
+    alignas( value_t ) char _storage[sizeof( value_t )];
+};
+
+// uses_fixture returns true if the test names the fixture in its flags
+static inline bool uses_fixture( const test_t& test, const fixture_t& fixture ) {
+    size_t      l    = 0;
+    const char* name = find_flag( test.flags(), "fixture", &l );
+    for ( ; name; name = find_flag( name + l, "fixture", &l ) ) {
+        if ( l == strlen( fixture.name() ) && strncmp( name, fixture.name(), l ) == 0 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline void setup_fixture( reporter_t& reporter, fixture_t& fixture ) {
+    if ( !fixture._built ) {
+        reporter.fixture_setup_begin( fixture );
+        fixture.build();
+        fixture._built = true;
+        reporter.fixture_setup_end( fixture );
+    }
+}
+
+static inline void teardown_fixture( reporter_t& reporter, fixture_t& fixture ) {
+    if ( fixture._built ) {
+        fixture.destroy();
+        fixture._built = false;
+        reporter.fixture_teardown( fixture );
+    }
+}
+
+// setup_fixtures builds all the fixtures used by a test that are not yet
+// built.
+static inline void setup_fixtures( reporter_t& reporter, const test_t& test ) {
+    auto fixtures = fixture_registry_t::instance().fixture_list();
+    for ( auto it = fixtures.begin(); it != fixtures.end(); it++ ) {
+        if ( uses_fixture( test, *it ) ) {
+            setup_fixture( reporter, *it );
+        }
+    }
+}
+
+// teardown_fixtures tears down all the built fixtures that are not used by
+// any test registered after `test`.
+static inline void teardown_fixtures( reporter_t& reporter, const test_t& test ) {
+    auto fixtures = fixture_registry_t::instance().fixture_list();
+    for ( auto it = fixtures.begin(); it != fixtures.end(); it++ ) {
+        if ( !it->built() ) {
+            continue;
+        }
+        bool used = false;
+        for ( const test_t* t = test._next; t && !used; t = t->_next ) {
+            used = uses_fixture( *t, *it );
+        }
+        if ( !used ) {
+            teardown_fixture( reporter, *it );
+        }
+    }
+}
+
+// teardown_all_fixtures tears down any fixture still built, including those
+// accessed by tests without naming them in their flags.
+static inline void teardown_all_fixtures( reporter_t& reporter ) {
+    auto fixtures = fixture_registry_t::instance().fixture_list();
+    for ( auto it = fixtures.begin(); it != fixtures.end(); it++ ) {
+        teardown_fixture( reporter, *it );
+    }
+}
+
+// use_fixture returns the value of a fixture, building it first if the
+// running test accessed it without naming it in its flags.
+template <typename value_t>
+const value_t& use_fixture( test_env_t& env, fixture_tt<value_t>& fixture ) {
+    setup_fixture( env.reporter, fixture );
+    return fixture.value();
+}
+
+// text_reporter_t is the reporter_t implementation printing out all events
+// in a verbose text format to an output_t.
+struct text_reporter_t : reporter_t {
+    text_reporter_t( output_t& output ) : output( output ) {
+    }
+    output_t& output;
+
+    virtual void test_begin( const test_t& test ) {
+        writer( output ).enter(
+            test.filename(), test.lineno(), test.type(), test.name() );
+    }
+
+    virtual void test_end( const test_t& test ) {
+        writer( output ).leave(
+            test.filename(), test.lineno(), test.type(), test.name() );
+        writer( output ).write_newline();
+    }
+
+    virtual void section_enter( const location_t& s ) {
+        writer( output ).enter( s.filename, s.lineno, s.prefix, s.name );
+    }
+
+    virtual void section_leave( const location_t& s ) {
+        writer( output ).leave( s.filename, s.lineno, s.prefix, s.name );
+    }
+
+    virtual void check_result(
+        const char* filename, int lineno, const char* expr, bool success,
+        const description_t& description ) {
+        writer( output ).report_prefix( filename, lineno, success );
+        description.describe( output );
+        writer( output ).write_newline();
+        if ( !success ) {
+            description.write_details( output );
+        }
+    }
+
+    virtual void section_timeout( const location_t& s ) {
+        writer( output ).timeout( s.filename, s.lineno, s.prefix, s.name );
+    }
+
+    virtual void test_timeout( const test_t& test ) {
+        writer( output ).timeout(
+            test.filename(), test.lineno(), test.type(), test.name() );
+        writer( output ).write_newline();
+    }
+
+    virtual void scratch_peak( const test_t& test, size_t peak ) {
+        writer( output ).write_prefix( test.filename(), test.lineno() );
+        writer( output ).write( "scratch: ", 9 );
+        writer( output ).write_int( int( peak ) );
+        writer( output ).write_cstr( " bytes peak" );
+        writer( output ).write_newline();
+    }
+
+    virtual void fixture_setup_begin( const fixture_t& fixture ) {
+        writer( output ).write_prefix( fixture.filename(), fixture.lineno() );
+        writer( output ).write( "setup: fixture ", 15 );
+        writer( output ).write_cstr( fixture.name() );
+        writer( output ).write_newline();
+        writer( output ).write_newline();
+    }
+
+    virtual void fixture_teardown( const fixture_t& fixture ) {
+        writer( output ).write_prefix( fixture.filename(), fixture.lineno() );
+        writer( output ).write( "teardown: fixture ", 18 );
+        writer( output ).write_cstr( fixture.name() );
+        writer( output ).write_newline();
+        writer( output ).write_newline();
+    }
+};
+
+// predicate_description_t is the description_t thunk for a value checked
+// against a predicate
+template <typename value_t, typename predicate_t>
+struct predicate_description_t : description_t {
+    predicate_description_t( const char* expr, const value_t& value, const predicate_t& pred )
+        : expr( expr ), value( value ), pred( pred ) {
+    }
+    const char*        expr;
+    const value_t&     value;
+    const predicate_t& pred;
+
+    virtual void describe( output_t& out ) const {
+        pred.describe( out, expr );
+    }
+    virtual void write_details( output_t& out ) const {
+        pred.write_details( out, value );
+    }
+};
+
+// bool_description_t is the description_t thunk for a value checked as a
+// boolean expression
+struct bool_description_t : description_t {
+    bool_description_t( const char* expr ) : expr( expr ) {
+    }
+    const char* expr;
+
+    virtual void describe( output_t& out ) const {
+        writer( out ).write_cstr( expr );
+        writer( out ).write( " == true", 8 );
+    }
+    virtual void write_details( output_t& out ) const {
+    }
+};
+
 // check_that checks a value against a predicate and reports the result to
 // the test framework
 template <typename value_t, typename predicate_t>
 bool check_that( test_env_t& env, const char* filename, int line, const char* expr, value_t value, predicate_t pred ) {
     bool success = pred.eval( value );
-    writer( env.output ).report_prefix( filename, line, success );
-    pred.describe( env.output, expr );
-    writer( env.output ).write_newline();
-    if ( !success ) {
-        pred.write_details( env.output, value );
-    }
+    env.reporter.check_result(
+        filename, line, expr, success,
+        predicate_description_t<value_t, predicate_t>( expr, value, pred ) );
     return success;
 }
 
@@ -524,34 +1085,67 @@ bool check_that( test_env_t& env, const char* filename, int line, const char* ex
 template <typename value_t>
 bool check( test_env_t& env, const char* filename, int line, const char* expr, value_t value ) {
     bool success = !!( value );
-    writer( env.output ).report_prefix( filename, line, success );
-    writer( env.output ).write_cstr( expr );
-    writer( env.output ).write( " == true\n", 9 );
-
+    env.reporter.check_result(
+        filename, line, expr, success, bool_description_t( expr ) );
     return success;
 }
 
-// run_all_tests runs all registered tests, using the provided output to
-// to print out progress and diagnostic
-static inline void run_all_tests( output_t& output ) {
+// run_leaf runs the current leaf section of a test, as selected by the last
+// call to env.repeat()
+static inline void run_leaf( test_env_t& env, const test_t& test ) {
+    env.reporter.test_begin( test );
+    test.run( env );
+#if MUTE_SCRATCH_SIZE > 0
+    if ( scratch().peak() > 0 ) {
+        env.reporter.scratch_peak( test, scratch().peak() );
+    }
+#endif
+    env.reporter.test_end( test );
+}
+
+// run_test runs all the leaf sections of a single test, reporting progress
+// and diagnostic to the reporter attached to the provided environment
+static inline void run_test( test_env_t& env, const test_t& test ) {
+    env.test = &test;
+    while ( env.repeat() ) {
+        run_leaf( env, test );
+    }
+}
+
+// run_all_tests runs all registered tests, reporting progress and diagnostic
+// to the provided reporter
+static inline void run_all_tests( reporter_t& reporter ) {
     auto tests = mute::test_registry_t::instance().test_list();
     for ( auto it = tests.begin(); it != tests.end(); it++ ) {
-        const mute::test_t& test = *it;
-        mute::test_env_t    env( output );
-
-        while ( env.repeat() ) {
-            writer( output ).enter(
-                test.filename(), test.lineno(), test.type(), test.name() );
+        mute::test_env_t env( reporter );
+        setup_fixtures( reporter, *it );
+        run_test( env, *it );
+        teardown_fixtures( reporter, *it );
+    }
+    teardown_all_fixtures( reporter );
+}
 
-            test.run( env );
+// run_all_tests runs all registered tests, using the provided output to
+// to print out progress and diagnostic
+static inline void run_all_tests( output_t& output ) {
+    text_reporter_t reporter( output );
+    run_all_tests( reporter );
+}
 
-            writer( output ).leave(
-                test.filename(), test.lineno(), test.type(), test.name() );
-            writer( output ).write_newline();
-        }
+// report_timeout reports a timeout event for each section currently entered,
+// innermost first, followed by the test itself. It is intended to be called
+// by a runner watchdog when a test fails to complete in time, in place of the
+// leave events that will never be reported.
+static inline void report_timeout( test_env_t& env ) {
+    for ( int i = env.depth() - 1; i >= 0; i-- ) {
+        env.reporter.section_timeout( env.section( i ) );
+    }
+    if ( env.test ) {
+        env.reporter.test_timeout( *env.test );
     }
 }
 
+
 }; // namespace mute
 
 // =============================================================================
@@ -590,11 +1184,18 @@ static inline void run_all_tests( output_t& output ) {
 #define __MUTE_SECTION( __type, __name )                                       \
     for ( mute::section_t section( __test_env, __FILE__, __LINE__, __type, __name ); section; )
 
-#define __MUTE_CHECK( __expr )                                                 \
-    mute::check( __test_env, __FILE__, __LINE__, MUTE_PP_STR( __expr ), ( __expr ) )
+// The checked expression is stringized by each macro taking it from user code,
+// before it is macro-expanded, so that FIXTURE() or FUZZ_DATA are reported as
+// written.
+#define __MUTE_CHECK_STR( __str, __expr )                                      \
+    mute::check( __test_env, __FILE__, __LINE__, __str, ( __expr ) )
 
+#define __MUTE_CHECK_THAT_STR( __str, __expr, __predicate )                    \
+    mute::check_that( __test_env, __FILE__, __LINE__, __str, ( __expr ), __predicate )
+
+#define __MUTE_CHECK( __expr ) __MUTE_CHECK_STR( #__expr, __expr )
 #define __MUTE_CHECK_THAT( __expr, __predicate )                               \
-    mute::check_that( __test_env, __FILE__, __LINE__, MUTE_PP_STR( __expr ), ( __expr ), __predicate )
+    __MUTE_CHECK_THAT_STR( #__expr, __expr, __predicate )
 
 #define SCENARIO( __name, __flags ) __MUTE_TEST( "Scenario: ", __name, __flags )
 #define GIVEN( __name ) __MUTE_SECTION( "given ", __name )
@@ -604,17 +1205,28 @@ static inline void run_all_tests( output_t& output ) {
 #define TEST_CASE( __name, __flags ) __MUTE_TEST( "", __name, __flags )
 #define SECTION( __name ) __MUTE_SECTION( "", __name )
 
-#define CHECK( __expr ) __MUTE_CHECK( __expr )
+#define SUITE_FIXTURE( __name, __type )                                        \
+    mute::fixture_tt<__type> MUTE_PP_CAT( mute_fixture_, __name )(              \
+        #__name, __FILE__, __LINE__ )
+#define DECLARE_SUITE_FIXTURE( __name, __type )                                \
+    extern mute::fixture_tt<__type> MUTE_PP_CAT( mute_fixture_, __name )
+#define FIXTURE( __name )                                                      \
+    mute::use_fixture( __test_env, MUTE_PP_CAT( mute_fixture_, __name ) )
+
+#define FUZZ_DATA ( __test_env.input_data )
+#define FUZZ_SIZE ( __test_env.input_size )
+
+#define CHECK( __expr ) __MUTE_CHECK_STR( #__expr, __expr )
 #define CHECK_THAT( __expr, __predicate )                                      \
-    __MUTE_CHECK_THAT( __expr, __predicate )
+    __MUTE_CHECK_THAT_STR( #__expr, __expr, __predicate )
 
 #define REQUIRE( __expr )                                                      \
-    if ( !__MUTE_CHECK( __expr ) ) {                                           \
+    if ( !__MUTE_CHECK_STR( #__expr, __expr ) ) {                              \
         continue;                                                              \
     }
 
 #define REQUIRE_THAT( __expr, __predicate )                                    \
-    if ( !__MUTE_CHECK_THAT( __expr, __predicate ) ) {                         \
+    if ( !__MUTE_CHECK_THAT_STR( #__expr, __expr, __predicate ) ) {            \
         continue;                                                              \
     }
 
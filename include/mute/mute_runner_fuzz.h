@@ -0,0 +1,180 @@
+// mute_runner_fuzz.h
+//
+// Fuzzing test runner, driving all the tests tagged with `fuzz` in their flags
+// with fuzzer provided input, accessible from the test body through FUZZ_DATA
+// and FUZZ_SIZE. Each input runs through all the leaf sections of each fuzz
+// test, within the same process.
+//
+// By default, the runner exports LLVMFuzzerTestOneInput() for use with
+// libFuzzer (`-fsanitize=fuzzer`) or any compatible driver, such as AFL++.
+// Nothing is printed on the fast path, and the first failed check is printed
+// to stderr before aborting the process, so that the fuzzer records a crash.
+//
+// When MUTE_FUZZ_REPLAY is defined, the runner also provides a main() function
+// that replays the inputs found in the files or directories given on the
+// command line, or read from stdin if none is given, printing the verbose
+// test output to stdout. Inputs go through LLVMFuzzerTestOneInput(), as they
+// would under a fuzzer. It builds without libFuzzer and exits with a non-zero
+// status if any check failed. `make test` builds a replay binary for each test
+// with a corpus directory under `test/corpus/`, and replays that corpus.
+
+#pragma once
+#include "mute/mute.h"
+
+// =============================================================================
+// Fuzzing entry point
+// =============================================================================
+
+struct stderr_output_t : mute::output_t {
+    virtual void write( const char* b, size_t l ) {
+        fwrite( b, l, 1, stderr );
+    }
+};
+
+// mute_fuzz_reporter_t ignores all events but failed checks, which are printed
+// out to stderr before aborting.
+struct mute_fuzz_reporter_t : mute::reporter_t {
+    virtual void check_result(
+        const char* filename, int lineno, const char* expr, bool success,
+        const mute::description_t& description ) {
+        if ( success ) {
+            return;
+        }
+        stderr_output_t out;
+        mute::text_reporter_t( out ).check_result(
+            filename, lineno, expr, success, description );
+        abort();
+    }
+};
+
+// mute_run_fuzz_tests runs all the tests tagged with `fuzz` against a single
+// input. Suite fixtures are built on first use and kept alive across inputs.
+static inline void mute_run_fuzz_tests(
+    mute::reporter_t& reporter, const uint8_t* data, size_t size ) {
+    auto tests = mute::test_registry_t::instance().test_list();
+    for ( auto it = tests.begin(); it != tests.end(); it++ ) {
+        if ( !mute::has_flag( it->flags(), "fuzz" ) ) {
+            continue;
+        }
+        mute::setup_fixtures( reporter, *it );
+        mute::test_env_t env( reporter );
+        env.input_data = data;
+        env.input_size = size;
+        mute::run_test( env, *it );
+    }
+}
+
+// mute_fuzz_reporter receives the events of all fuzz tests run through
+// LLVMFuzzerTestOneInput(). It defaults to a mute_fuzz_reporter_t, and is
+// replaced by the corpus replay driver.
+static mute::reporter_t* mute_fuzz_reporter = nullptr;
+
+extern "C" int LLVMFuzzerTestOneInput( const uint8_t* data, size_t size ) {
+    static mute_fuzz_reporter_t reporter;
+    if ( !mute_fuzz_reporter ) {
+        mute_fuzz_reporter = &reporter;
+    }
+    mute_run_fuzz_tests( *mute_fuzz_reporter, data, size );
+    return 0;
+}
+
+// =============================================================================
+// Standalone corpus replay
+// =============================================================================
+
+#ifdef MUTE_FUZZ_REPLAY
+#include <dirent.h>
+#include <sys/stat.h>
+
+static const size_t mute_fuzz_max_input_size = 1024 * 1024;
+
+struct stdout_output_t : mute::output_t {
+    virtual void write( const char* b, size_t l ) {
+        fwrite( b, l, 1, stdout );
+    }
+};
+
+// mute_replay_reporter_t prints out all events like text_reporter_t, and
+// keeps track of the number of failed checks.
+struct mute_replay_reporter_t : mute::text_reporter_t {
+    mute_replay_reporter_t( mute::output_t& output ) : text_reporter_t( output ) {
+    }
+
+    virtual void check_result(
+        const char* filename, int lineno, const char* expr, bool success,
+        const mute::description_t& description ) {
+        if ( !success ) {
+            failed++;
+        }
+        text_reporter_t::check_result( filename, lineno, expr, success, description );
+    }
+
+    int failed = 0;
+};
+
+static inline bool mute_replay_file( FILE* f, const char* name ) {
+    static uint8_t buffer[mute_fuzz_max_input_size + 1];
+    size_t         size = fread( buffer, 1, sizeof( buffer ), f );
+    if ( size > mute_fuzz_max_input_size ) {
+        fprintf( stderr, "%s: input too large, skipped\n", name );
+        return false;
+    }
+    printf( "# replaying %s (%zu bytes)\n\n", name, size );
+    LLVMFuzzerTestOneInput( buffer, size );
+    return true;
+}
+
+// mute_replay_path replays a single input file, or all the files in a
+// directory, recursively and in sorted order so that the output is stable.
+static inline bool mute_replay_path( const char* path ) {
+    struct stat st;
+    if ( stat( path, &st ) != 0 ) {
+        fprintf( stderr, "%s: cannot access input\n", path );
+        return false;
+    }
+
+    if ( S_ISDIR( st.st_mode ) ) {
+        struct dirent** entries = nullptr;
+        int             count   = scandir( path, &entries, nullptr, alphasort );
+        if ( count < 0 ) {
+            fprintf( stderr, "%s: cannot open directory\n", path );
+            return false;
+        }
+        bool success = true;
+        for ( int i = 0; i < count; i++ ) {
+            if ( entries[i]->d_name[0] != '.' ) {
+                char child[4096];
+                snprintf( child, sizeof( child ), "%s/%s", path, entries[i]->d_name );
+                success = mute_replay_path( child ) && success;
+            }
+            free( entries[i] );
+        }
+        free( entries );
+        return success;
+    }
+
+    FILE* f = fopen( path, "rb" );
+    if ( !f ) {
+        fprintf( stderr, "%s: cannot open input\n", path );
+        return false;
+    }
+    bool success = mute_replay_file( f, path );
+    fclose( f );
+    return success;
+}
+
+int main( int argc, char* argv[] ) {
+    stdout_output_t        out;
+    mute_replay_reporter_t reporter( out );
+    mute_fuzz_reporter = &reporter;
+
+    bool success = true;
+    if ( argc < 2 ) {
+        success = mute_replay_file( stdin, "<stdin>" );
+    }
+    for ( int i = 1; i < argc; i++ ) {
+        success = mute_replay_path( argv[i] ) && success;
+    }
+    return ( success && reporter.failed == 0 ) ? 0 : 1;
+}
+#endif // MUTE_FUZZ_REPLAY
@@ -1,16 +1,860 @@
 // mute_runner_stdout.h
+//
+// Default host test runner, writing all test output to stdout. Supported
+// command line options:
+//
+//   --timeout=<duration>         default per-test timeout
+//   --global-timeout=<duration>  timeout for the whole run
+//   --timeout-exit               exit on the first test timeout (default,
+//                                except in stress mode)
+//   --timeout-continue           abort the test that timed out and move on to
+//                                the next test, on a best-effort basis
+//   --test=<text>                only run tests whose name contains <text>
+//   --repeat=<count>             stress mode, run each leaf <count> times
+//   --repeat-for=<duration>      stress mode, run each leaf for <duration>
+//   --until-failure              stress mode, stop repeating a leaf upon its
+//                                first failure, or after <count> or <duration>
+//                                if also given
+//   --stats=<path>               publish live statistics in a memory mapped
+//                                file, readable with the mute_stats viewer
+//   --quiet                      only print failed checks instead of the
+//                                verbose test output; in stress mode, only
+//                                print the summaries
+//
+// The exit status is 1 if any check failed, and `mute_runner_timeout_status`
+// if any test timed out.
+//
+// Durations are expressed in seconds, or in milliseconds with an 'ms' suffix.
+// Individual tests can override the default per-test timeout with a
+// `timeout=<duration>` tag in their flags, e.g. `SCENARIO( "...", "[timeout=2]"
+// )`. A timeout of 0 disables the watchdog. Upon timeout, the runner reports
+// a `timeout:` event for each section being executed and exits with status
+// `mute_runner_timeout_status`, from the signal handler and using only
+// async-signal-safe calls. With `--timeout-continue`, the runner instead jumps
+// out of the test that timed out and moves on to the next one, exiting with
+// the same status once done. This skips the destructors of the abandoned test
+// and leaves any lock held by the code under test locked, so later tests may
+// misbehave: continuing is best-effort only.
+//
+// In stress mode, each leaf section is run repeatedly within the same process,
+// with the watchdog applying to each iteration. Only the output of the first
+// failing iteration of each leaf is printed, followed by a `stress:` summary
+// line with the number of iterations, the failure rate and the number of
+// iterations per second. The exit status is 1 if any iteration failed.
+// Timeouts continue by default in stress mode: an iteration that times out is
+// reported, counts as failed and ends the repetition of its leaf, and the run
+// moves on to the next leaf. When the first iteration of a leaf times out, the
+// sections it never reached are unknown: the enclosing sections are run again
+// looking for them, which can show up as a summary for the enclosing section.
+// With `--until-failure` alone, a leaf that never fails is repeated until the
+// global timeout, if any.
 
 #pragma once
 #include "mute/mute.h"
+#include "mute/mute_stats.h"
 
-struct stdout_output_t : mute::output_t{
-    virtual void write(const char * b, size_t l) {
-        fwrite(b, l, 1, stdout);
+#include <fcntl.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+// mute_write_fd writes a buffer to a file descriptor, using only
+// async-signal-safe calls.
+static inline void mute_write_fd( int fd, const char* b, size_t l ) {
+    while ( l > 0 ) {
+        ssize_t n = ::write( fd, b, l );
+        if ( n <= 0 ) {
+            return;
+        }
+        b += n;
+        l -= n;
+    }
+}
+
+// stdout_output_t writes to the stdout file descriptor through its own fixed
+// size buffer rather than through stdio, so that pending output can be flushed
+// from the watchdog signal handler. The buffer is flushed at the end of each
+// line, after any output pending in stdio, so that output printed by the code
+// under test stays in order with the test events around it.
+struct stdout_output_t : mute::output_t {
+    ~stdout_output_t() {
+        flush();
+    }
+
+    virtual void write( const char* b, size_t l ) {
+        if ( l > sizeof( buffer ) - length ) {
+            flush();
+            if ( l > sizeof( buffer ) ) {
+                mute_write_fd( 1, b, l );
+                return;
+            }
+        }
+        memcpy( buffer + length, b, l );
+        length = length + l;
+        if ( l > 0 && b[l - 1] == '\n' ) {
+            flush();
+        }
+    }
+
+    void flush() {
+        fflush( stdout );
+        mute_write_fd( 1, buffer, length );
+        length = 0;
+    }
+
+    char            buffer[4096];
+    volatile size_t length = 0;
+};
+
+// mute_capture_output_t accumulates the output of a single iteration into a
+// fixed size buffer, truncating it if needed.
+struct mute_capture_output_t : mute::output_t {
+    virtual void write( const char* b, size_t l ) {
+        if ( l > sizeof( buffer ) - length ) {
+            l         = sizeof( buffer ) - length;
+            truncated = true;
+        }
+        memcpy( buffer + length, b, l );
+        length = length + l;
+    }
+
+    void clear() {
+        length    = 0;
+        truncated = false;
+    }
+
+    char            buffer[64 * 1024];
+    volatile size_t length    = 0;
+    bool            truncated = false;
+};
+
+// =============================================================================
+// Command line options
+// =============================================================================
+
+static const int mute_runner_timeout_status = 124;
+
+struct mute_runner_options_t {
+    long        timeout_ms        = 0;
+    long        global_timeout_ms = 0;
+    bool        timeout_exit      = false;
+    bool        timeout_continue  = false;
+    const char* test_filter       = nullptr;
+    long        repeat_count      = 0;
+    long        repeat_ms         = 0;
+    bool        until_failure     = false;
+    const char* stats_path        = nullptr;
+    bool        quiet             = false;
+
+    bool stress() const {
+        return repeat_count > 0 || repeat_ms > 0 || until_failure;
+    }
+
+    // continue_on_timeout() returns true if the runner should move on after
+    // a per-test timeout, either as requested or by default in stress mode.
+    bool continue_on_timeout() const {
+        return timeout_continue || ( stress() && !timeout_exit );
+    }
+};
+
+// mute_parse_duration_ms parses a duration in seconds, or in milliseconds
+// with an 'ms' suffix, and returns it in milliseconds, or -1 if invalid.
+static inline long mute_parse_duration_ms( const char* s, size_t l ) {
+    char buf[32];
+    if ( l == 0 || l >= sizeof( buf ) ) {
+        return -1;
+    }
+    memcpy( buf, s, l );
+    buf[l] = 0;
+
+    char* end = nullptr;
+    long  v   = strtol( buf, &end, 10 );
+    if ( end == buf || v < 0 ) {
+        return -1;
+    }
+    if ( *end == 0 || strcmp( end, "s" ) == 0 ) {
+        return v * 1000;
+    }
+    if ( strcmp( end, "ms" ) == 0 ) {
+        return v;
+    }
+    return -1;
+}
+
+static inline bool mute_parse_duration_option(
+    const char* arg, const char* name, long* value ) {
+    size_t l = strlen( name );
+    if ( strncmp( arg, name, l ) != 0 || arg[l] != '=' ) {
+        return false;
+    }
+    *value = mute_parse_duration_ms( arg + l + 1, strlen( arg + l + 1 ) );
+    return true;
+}
+
+static inline bool mute_parse_options(
+    int argc, char* argv[], mute_runner_options_t& options ) {
+    for ( int i = 1; i < argc; i++ ) {
+        const char* arg = argv[i];
+        if ( mute_parse_duration_option( arg, "--timeout", &options.timeout_ms ) ) {
+            if ( options.timeout_ms < 0 ) {
+                fprintf( stderr, "invalid duration: %s\n", arg );
+                return false;
+            }
+        } else if ( mute_parse_duration_option(
+                        arg, "--global-timeout", &options.global_timeout_ms ) ) {
+            if ( options.global_timeout_ms < 0 ) {
+                fprintf( stderr, "invalid duration: %s\n", arg );
+                return false;
+            }
+        } else if ( strcmp( arg, "--timeout-exit" ) == 0 ) {
+            options.timeout_exit     = true;
+            options.timeout_continue = false;
+        } else if ( strcmp( arg, "--timeout-continue" ) == 0 ) {
+            options.timeout_exit     = false;
+            options.timeout_continue = true;
+        } else if ( strncmp( arg, "--test=", 7 ) == 0 ) {
+            options.test_filter = arg + 7;
+        } else if ( strncmp( arg, "--repeat=", 9 ) == 0 ) {
+            options.repeat_count = strtol( arg + 9, nullptr, 10 );
+            if ( options.repeat_count <= 0 ) {
+                fprintf( stderr, "invalid count: %s\n", arg );
+                return false;
+            }
+        } else if ( mute_parse_duration_option(
+                        arg, "--repeat-for", &options.repeat_ms ) ) {
+            if ( options.repeat_ms <= 0 ) {
+                fprintf( stderr, "invalid duration: %s\n", arg );
+                return false;
+            }
+        } else if ( strcmp( arg, "--until-failure" ) == 0 ) {
+            options.until_failure = true;
+        } else if ( strncmp( arg, "--stats=", 8 ) == 0 ) {
+            options.stats_path = arg + 8;
+        } else if ( strcmp( arg, "--quiet" ) == 0 ) {
+            options.quiet = true;
+        } else {
+            fprintf( stderr, "unknown option: %s\n", arg );
+            fprintf(
+                stderr,
+                "usage: %s [--timeout=<duration>] "
+                "[--global-timeout=<duration>] [--timeout-exit] "
+                "[--timeout-continue] "
+                "[--test=<text>] [--repeat=<count>] "
+                "[--repeat-for=<duration>] [--until-failure] "
+                "[--stats=<path>] [--quiet]\n",
+                argv[0] );
+            return false;
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// Watchdog, based on a SIGALRM interval timer. Upon expiration, the signal
+// handler either reports the section stack of the running test and exits the
+// process, using only async-signal-safe calls, or jumps back into the runner
+// loop which then reports the timeout.
+// =============================================================================
+
+struct mute_watchdog_t {
+    mute::test_env_t*      env;
+    stdout_output_t*       output;
+    mute_capture_output_t* capture;
+    mute_stats_t*          stats;
+    sigjmp_buf             jmp;
+    bool                   exit;
+};
+static mute_watchdog_t mute_watchdog;
+
+static inline long mute_now_ms() {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return long( ts.tv_sec ) * 1000 + ts.tv_nsec / 1000000;
+}
+
+static inline long long mute_now_us() {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (long long)( ts.tv_sec ) * 1000000 + ts.tv_nsec / 1000;
+}
+
+static inline void mute_watchdog_arm( long ms ) {
+    struct itimerval t;
+    memset( &t, 0, sizeof( t ) );
+    t.it_value.tv_sec  = ms / 1000;
+    t.it_value.tv_usec = ( ms % 1000 ) * 1000;
+    setitimer( ITIMER_REAL, &t, nullptr );
+}
+
+// mute_write_timeout_safe writes a `timeout:` event in the same format as
+// text_reporter_t, using only async-signal-safe calls.
+static void mute_write_timeout_safe(
+    const char* filename, int lineno, const char* prefix, const char* name ) {
+    char  digits[16];
+    char* p = digits + sizeof( digits );
+    do {
+        *--p = char( '0' + lineno % 10 );
+        lineno /= 10;
+    } while ( lineno > 0 && p > digits );
+
+    mute_write_fd( 1, filename, strlen( filename ) );
+    mute_write_fd( 1, ":", 1 );
+    mute_write_fd( 1, p, digits + sizeof( digits ) - p );
+    mute_write_fd( 1, ": timeout: ", 11 );
+    mute_write_fd( 1, prefix, strlen( prefix ) );
+    mute_write_fd( 1, name, strlen( name ) );
+    mute_write_fd( 1, "\n", 1 );
+}
+
+static void mute_watchdog_handler( int ) {
+    if ( !mute_watchdog.exit ) {
+        siglongjmp( mute_watchdog.jmp, 1 );
+    }
+
+    if ( mute_watchdog.output ) {
+        stdout_output_t& out = *mute_watchdog.output;
+        mute_write_fd( 1, out.buffer, out.length );
+    }
+    if ( mute_watchdog.capture ) {
+        mute_capture_output_t& capture = *mute_watchdog.capture;
+        mute_write_fd( 1, capture.buffer, capture.length );
+    }
+    if ( mute::test_env_t* env = mute_watchdog.env ) {
+        for ( int i = env->depth() - 1; i >= 0; i-- ) {
+            const mute::location_t& s = env->section( i );
+            mute_write_timeout_safe( s.filename, s.lineno, s.prefix, s.name );
+        }
+        if ( const mute::test_t* test = env->test ) {
+            mute_write_timeout_safe(
+                test->filename(), test->lineno(), test->type(), test->name() );
+        }
+        mute_write_fd( 1, "\n", 1 );
+    }
+    if ( mute_stats_t* stats = mute_watchdog.stats ) {
+        // Lock-free atomics are async-signal-safe, see mute_stats.h
+        struct timespec ts;
+        clock_gettime( CLOCK_REALTIME, &ts );
+        int64_t now = int64_t( ts.tv_sec ) * 1000000 + ts.tv_nsec / 1000;
+        stats->timeouts.fetch_add( 1, std::memory_order_relaxed );
+        stats->elapsed_us.store( now - stats->start_time_us, std::memory_order_relaxed );
+        stats->state.store( mute_stats_done, std::memory_order_release );
+    }
+    _exit( mute_runner_timeout_status );
+}
+
+// mute_test_timeout_ms returns the timeout applicable to a test, taking into
+// account any `timeout=` tag in its flags.
+static inline long mute_test_timeout_ms(
+    const mute::test_t& test, const mute_runner_options_t& options ) {
+    size_t      l     = 0;
+    const char* value = mute::find_flag( test.flags(), "timeout", &l );
+    if ( value ) {
+        long ms = mute_parse_duration_ms( value, l );
+        if ( ms >= 0 ) {
+            return ms;
+        }
+    }
+    return options.timeout_ms;
+}
+
+// mute_watchdog_start arms the watchdog for running a test, or an iteration
+// of a leaf in stress mode, taking into account the time remaining before
+// the global timeout since `start`.
+static inline void mute_watchdog_start(
+    const mute::test_t& test, const mute_runner_options_t& options, long start ) {
+    long timeout = mute_test_timeout_ms( test, options );
+    bool global  = false;
+    if ( options.global_timeout_ms > 0 ) {
+        long remaining = options.global_timeout_ms - ( mute_now_ms() - start );
+        if ( remaining <= 0 ) {
+            remaining = 1;
+        }
+        if ( timeout == 0 || remaining <= timeout ) {
+            timeout = remaining;
+            global  = true;
+        }
+    }
+
+    mute_watchdog.exit = global || !options.continue_on_timeout();
+    if ( timeout > 0 ) {
+        mute_watchdog_arm( timeout );
+    }
+}
+
+// =============================================================================
+// Runner reporter
+// =============================================================================
+
+// mute_runner_reporter_t extends text_reporter_t with the build time of each
+// suite fixture, reported on stderr to keep the test output deterministic,
+// and keeps track of the number of failed checks.
+struct mute_runner_reporter_t : mute::text_reporter_t {
+    mute_runner_reporter_t( mute::output_t& output ) : text_reporter_t( output ) {
+    }
+    long failed_checks = 0;
+
+    virtual void check_result(
+        const char* filename, int lineno, const char* expr, bool success,
+        const mute::description_t& description ) {
+        if ( !success ) {
+            failed_checks++;
+        }
+        text_reporter_t::check_result( filename, lineno, expr, success, description );
     }
+
+    virtual void fixture_setup_begin( const mute::fixture_t& fixture ) {
+        text_reporter_t::fixture_setup_begin( fixture );
+        _fixture_start = mute_now_us();
+    }
+
+    virtual void fixture_setup_end( const mute::fixture_t& fixture ) {
+        long long elapsed = mute_now_us() - _fixture_start;
+        fprintf(
+            stderr, "%s:%d: fixture: %s built in %.3f ms\n", fixture.filename(),
+            fixture.lineno(), fixture.name(), elapsed / 1000.0 );
+    }
+
+private:
+    long long _fixture_start = 0;
 };
 
+// mute_quiet_reporter_t ignores all events but failed checks, which are
+// printed out and counted, so that failures remain visible with `--quiet`.
+struct mute_quiet_reporter_t : mute::reporter_t {
+    mute_quiet_reporter_t( mute::output_t& output ) : _text( output ) {
+    }
+    long failed_checks = 0;
+
+    virtual void check_result(
+        const char* filename, int lineno, const char* expr, bool success,
+        const mute::description_t& description ) {
+        if ( !success ) {
+            failed_checks++;
+            _text.check_result( filename, lineno, expr, success, description );
+        }
+    }
+
+private:
+    mute::text_reporter_t _text;
+};
+
+// =============================================================================
+// Stress mode
+// =============================================================================
+
+// mute_stress_reporter_t captures the text output of each iteration, keeping
+// track of failed checks and of the leaf section being run, and only prints
+// it out on demand, or upon timeout. Other events are printed out directly.
+// When quiet, nothing is printed but the summaries written by the runner.
+struct mute_stress_reporter_t : mute_runner_reporter_t {
+    mute_stress_reporter_t( mute::output_t& output, bool quiet )
+        : mute_runner_reporter_t( output ), quiet( quiet ), _text( _capture ) {
+    }
+    const bool       quiet;
+    bool             failed = false;
+    mute::location_t leaf   = {};
+
+    void begin_iteration() {
+        _capture.clear();
+        failed = false;
+        leaf   = {};
+    }
+
+    mute_capture_output_t& capture() {
+        return _capture;
+    }
+
+    void flush() {
+        if ( !quiet ) {
+            output.write( _capture.buffer, _capture.length );
+            if ( _capture.truncated ) {
+                mute::writer( output ).write_cstr( "...\n\n" );
+            }
+        }
+        _capture.clear();
+    }
+
+    virtual void test_begin( const mute::test_t& test ) {
+        leaf = {test.filename(), test.lineno(), test.type(), test.name()};
+        _text.test_begin( test );
+    }
+    virtual void test_end( const mute::test_t& test ) {
+        _text.test_end( test );
+    }
+    virtual void section_enter( const mute::location_t& section ) {
+        leaf = section;
+        _text.section_enter( section );
+    }
+    virtual void section_leave( const mute::location_t& section ) {
+        _text.section_leave( section );
+    }
+    virtual void check_result(
+        const char* filename, int lineno, const char* expr, bool success,
+        const mute::description_t& description ) {
+        failed = failed || !success;
+        _text.check_result( filename, lineno, expr, success, description );
+    }
+    virtual void section_timeout( const mute::location_t& section ) {
+        flush();
+        if ( !quiet ) {
+            mute_runner_reporter_t::section_timeout( section );
+        }
+    }
+    virtual void test_timeout( const mute::test_t& test ) {
+        flush();
+        if ( !quiet ) {
+            mute_runner_reporter_t::test_timeout( test );
+        }
+    }
+    virtual void scratch_peak( const mute::test_t& test, size_t peak ) {
+        _text.scratch_peak( test, peak );
+    }
+    virtual void fixture_setup_begin( const mute::fixture_t& fixture ) {
+        if ( !quiet ) {
+            mute_runner_reporter_t::fixture_setup_begin( fixture );
+        }
+    }
+    virtual void fixture_setup_end( const mute::fixture_t& fixture ) {
+        if ( !quiet ) {
+            mute_runner_reporter_t::fixture_setup_end( fixture );
+        }
+    }
+    virtual void fixture_teardown( const mute::fixture_t& fixture ) {
+        if ( !quiet ) {
+            mute_runner_reporter_t::fixture_teardown( fixture );
+        }
+    }
+
+private:
+    mute_capture_output_t _capture;
+    mute::text_reporter_t _text;
+};
+
+struct mute_run_result_t {
+    int  timeouts = 0;
+    long failures = 0;
+};
+
+// mute_stress_test runs each leaf of a test repeatedly, as configured in the
+// options, and reports a summary for each leaf. Each iteration sets its own
+// watchdog jump point, so that a timeout only ends the repetition of the
+// current leaf. It returns the number of failed iterations, including those
+// that timed out, and the number of timeouts.
+static inline mute_run_result_t mute_stress_test(
+    mute::test_env_t& env, mute_stress_reporter_t& reporter,
+    const mute::test_t& test, const mute_runner_options_t& options,
+    long start ) {
+    mute_run_result_t result;
+    env.test = &test;
+    while ( env.repeat() ) {
+        long long     leaf_start = mute_now_us();
+        volatile long iterations = 0;
+        volatile long failures   = 0;
+        while ( true ) {
+            reporter.begin_iteration();
+            if ( sigsetjmp( mute_watchdog.jmp, 1 ) != 0 ) {
+                mute::report_timeout( env );
+                env.unwind();
+                iterations = iterations + 1;
+                failures   = failures + 1;
+                result.timeouts++;
+                break;
+            }
+            mute_watchdog_start( test, options, start );
+            mute::run_leaf( env, test );
+            mute_watchdog_arm( 0 );
+            iterations = iterations + 1;
+
+            if ( reporter.failed ) {
+                if ( failures == 0 ) {
+                    reporter.flush();
+                }
+                failures = failures + 1;
+                if ( options.until_failure ) {
+                    break;
+                }
+            }
+            if ( options.repeat_count > 0 && iterations >= options.repeat_count ) {
+                break;
+            }
+            if ( options.repeat_ms > 0 &&
+                 mute_now_us() - leaf_start >= options.repeat_ms * 1000LL ) {
+                break;
+            }
+            env.rewind();
+        }
+
+        long long elapsed = mute_now_us() - leaf_start;
+        long      n       = iterations;
+        long      failed  = failures;
+        char      buf[128];
+        int       l = snprintf(
+            buf, sizeof( buf ),
+            ": %ld iterations, %ld failed (%.2f%%), %.0f iterations/s\n\n", n,
+            failed, 100.0 * failed / n, elapsed > 0 ? n * 1e6 / elapsed : 0.0 );
+        mute::writer_t<mute::output_t> w( reporter.output );
+        w.write_prefix( reporter.leaf.filename, reporter.leaf.lineno );
+        w.write( "stress: ", 8 );
+        w.write_cstr( reporter.leaf.prefix );
+        w.write_cstr( reporter.leaf.name );
+        if ( l > 0 && size_t( l ) < sizeof( buf ) ) {
+            w.write( buf, l );
+        }
+        result.failures += failed;
+    }
+    return result;
+}
+
+// =============================================================================
+// Live statistics page
+// =============================================================================
+
+// mute_stats_open creates the statistics file and maps it in memory, or
+// returns nullptr on failure.
+static inline mute_stats_t* mute_stats_open( const char* path ) {
+    int fd = open( path, O_RDWR | O_CREAT | O_TRUNC, 0644 );
+    if ( fd < 0 || ftruncate( fd, sizeof( mute_stats_t ) ) != 0 ) {
+        fprintf( stderr, "%s: cannot create stats file\n", path );
+        if ( fd >= 0 ) {
+            close( fd );
+        }
+        return nullptr;
+    }
+    void* p = mmap(
+        nullptr, sizeof( mute_stats_t ), PROT_READ | PROT_WRITE, MAP_SHARED,
+        fd, 0 );
+    close( fd );
+    if ( p == MAP_FAILED ) {
+        fprintf( stderr, "%s: cannot map stats file\n", path );
+        return nullptr;
+    }
+
+    struct timespec ts;
+    clock_gettime( CLOCK_REALTIME, &ts );
+
+    mute_stats_t* stats  = new ( p ) mute_stats_t();
+    stats->magic         = mute_stats_magic;
+    stats->version       = mute_stats_version;
+    stats->pid           = getpid();
+    stats->start_time_us = int64_t( ts.tv_sec ) * 1000000 + ts.tv_nsec / 1000;
+    stats->state.store( mute_stats_running, std::memory_order_release );
+    return stats;
+}
+
+// mute_stats_reporter_t updates the statistics page from the test events,
+// forwarding all events to another reporter. It is only used once the page
+// is successfully mapped.
+struct mute_stats_reporter_t : mute::reporter_t {
+    mute_stats_reporter_t( mute_stats_t* stats, mute::reporter_t& next )
+        : stats( stats ), next( next ) {
+    }
+    mute_stats_t*     stats;
+    mute::reporter_t& next;
+
+    virtual void test_begin( const mute::test_t& test ) {
+        if ( &test != _test ) {
+            _test = &test;
+            stats->tests_run.fetch_add( 1, std::memory_order_relaxed );
+        }
+        _depth = 0;
+        stats->set_names( test.type(), test.name(), "", "" );
+        stats->leaves.fetch_add( 1, std::memory_order_relaxed );
+        stats->elapsed_us.store( mute_now_us() - _start, std::memory_order_relaxed );
+        next.test_begin( test );
+    }
+    virtual void test_end( const mute::test_t& test ) {
+        next.test_end( test );
+    }
+    virtual void section_enter( const mute::location_t& section ) {
+        if ( _depth < mute::test_env_t::max_depth ) {
+            _sections[_depth] = section;
+        }
+        _depth++;
+        stats->set_names( "", nullptr, section.prefix, section.name );
+        next.section_enter( section );
+    }
+    virtual void section_leave( const mute::location_t& section ) {
+        _depth--;
+        if ( _depth > 0 ) {
+            const mute::location_t& parent = _sections[_depth - 1];
+            stats->set_names( "", nullptr, parent.prefix, parent.name );
+        } else {
+            stats->set_names( "", nullptr, "", "" );
+        }
+        next.section_leave( section );
+    }
+    virtual void check_result(
+        const char* filename, int lineno, const char* expr, bool success,
+        const mute::description_t& description ) {
+        if ( success ) {
+            stats->checks_passed.fetch_add( 1, std::memory_order_relaxed );
+        } else {
+            stats->checks_failed.fetch_add( 1, std::memory_order_relaxed );
+        }
+        next.check_result( filename, lineno, expr, success, description );
+    }
+    virtual void section_timeout( const mute::location_t& section ) {
+        next.section_timeout( section );
+    }
+    virtual void test_timeout( const mute::test_t& test ) {
+        stats->timeouts.fetch_add( 1, std::memory_order_relaxed );
+        next.test_timeout( test );
+    }
+    virtual void scratch_peak( const mute::test_t& test, size_t peak ) {
+        next.scratch_peak( test, peak );
+    }
+    virtual void fixture_setup_begin( const mute::fixture_t& fixture ) {
+        next.fixture_setup_begin( fixture );
+    }
+    virtual void fixture_setup_end( const mute::fixture_t& fixture ) {
+        next.fixture_setup_end( fixture );
+    }
+    virtual void fixture_teardown( const mute::fixture_t& fixture ) {
+        next.fixture_teardown( fixture );
+    }
+
+    void done() {
+        stats->elapsed_us.store( mute_now_us() - _start, std::memory_order_relaxed );
+        stats->state.store( mute_stats_done, std::memory_order_release );
+    }
+
+private:
+    long long           _start = mute_now_us();
+    const mute::test_t* _test  = nullptr;
+    int                 _depth = 0;
+    mute::location_t    _sections[mute::test_env_t::max_depth];
+};
+
+// =============================================================================
+// Main test loop
+// =============================================================================
+
+// mute_run_tests runs each selected test under the supervision of the
+// watchdog, reporting to `reporter`, or repeatedly through `stress_reporter`
+// in stress mode.
+static inline mute_run_result_t mute_run_tests(
+    mute::reporter_t& reporter, mute_stress_reporter_t* stress_reporter,
+    const mute_runner_options_t& options ) {
+    signal( SIGALRM, mute_watchdog_handler );
+
+    auto tests = mute::test_registry_t::instance().test_list();
+
+    mute::reporter_t* r     = stress_reporter ? stress_reporter : &reporter;
+    mute_stats_t*     stats = nullptr;
+    if ( options.stats_path ) {
+        stats = mute_stats_open( options.stats_path );
+    }
+    mute_stats_reporter_t stats_reporter( stats, *r );
+    if ( stats ) {
+        uint32_t total = 0;
+        for ( auto it = tests.begin(); it != tests.end(); it++ ) {
+            if ( !options.test_filter || strstr( it->name(), options.test_filter ) ) {
+                total++;
+            }
+        }
+        stats->tests_total.store( total, std::memory_order_relaxed );
+        r                   = &stats_reporter;
+        mute_watchdog.stats = stats;
+    }
+
+    long          start    = mute_now_ms();
+    volatile int  timeouts = 0;
+    volatile long failures = 0;
+
+    for ( auto it = tests.begin(); it != tests.end(); it++ ) {
+        const mute::test_t& test = *it;
+        mute::test_env_t    env( *r );
+        if ( options.test_filter && !strstr( test.name(), options.test_filter ) ) {
+            continue;
+        }
+
+        mute_watchdog.env = &env;
+        if ( stress_reporter ) {
+            mute_watchdog.capture = &stress_reporter->capture();
+            mute::setup_fixtures( *r, test );
+            mute_run_result_t result = mute_stress_test(
+                env, *stress_reporter, test, options, start );
+            timeouts = timeouts + result.timeouts;
+            failures = failures + result.failures;
+        } else if ( sigsetjmp( mute_watchdog.jmp, 1 ) == 0 ) {
+            mute::setup_fixtures( *r, test );
+            mute_watchdog_start( test, options, start );
+            mute::run_test( env, test );
+            mute_watchdog_arm( 0 );
+        } else {
+            mute::report_timeout( env );
+            env.unwind();
+            timeouts = timeouts + 1;
+        }
+        mute_watchdog.env     = nullptr;
+        mute_watchdog.capture = nullptr;
+        mute::teardown_fixtures( *r, test );
+    }
+    mute::teardown_all_fixtures( *r );
+    if ( stats ) {
+        mute_watchdog.stats = nullptr;
+        stats_reporter.done();
+    }
+
+    mute_run_result_t result;
+    result.timeouts = timeouts;
+    result.failures = failures;
+    return result;
+}
+
+// mute_run_all_tests is the equivalent of mute::run_all_tests(), running each
+// selected test under the supervision of the watchdog. It returns the number
+// of tests that timed out. Stress mode formats its own output and is not
+// available with a custom reporter; stress options are ignored.
+static inline int mute_run_all_tests(
+    mute::reporter_t& reporter, const mute_runner_options_t& options ) {
+    mute_runner_options_t o = options;
+    o.repeat_count          = 0;
+    o.repeat_ms             = 0;
+    o.until_failure         = false;
+    return mute_run_tests( reporter, nullptr, o ).timeouts;
+}
+
+// mute_run_all_tests runs each selected test with the verbose text output,
+// or repeatedly in stress mode, printing out progress and diagnostic to the
+// provided output. Failures count failed checks, or failed iterations in
+// stress mode.
+static inline mute_run_result_t mute_run_all_tests(
+    mute::output_t& output, const mute_runner_options_t& options ) {
+    if ( options.stress() ) {
+        mute_stress_reporter_t reporter( output, options.quiet );
+        return mute_run_tests( reporter, &reporter, options );
+    }
+    if ( options.quiet ) {
+        mute_quiet_reporter_t reporter( output );
+        mute_run_result_t     result = mute_run_tests( reporter, nullptr, options );
+        result.failures              = reporter.failed_checks;
+        return result;
+    }
+    mute_runner_reporter_t reporter( output );
+    mute_run_result_t      result = mute_run_tests( reporter, nullptr, options );
+    result.failures               = reporter.failed_checks;
+    return result;
+}
+
 int main( int argc, char* argv[] ) {
-    stdout_output_t out;
-    mute::run_all_tests( out );
+    mute_runner_options_t options;
+    if ( !mute_parse_options( argc, argv, options ) ) {
+        return 2;
+    }
+
+    static stdout_output_t out;
+    mute_watchdog.output     = &out;
+    mute_run_result_t result = mute_run_all_tests( out, options );
+    out.flush();
+    if ( result.timeouts > 0 ) {
+        return mute_runner_timeout_status;
+    }
+    if ( result.failures > 0 ) {
+        return 1;
+    }
     return 0;
 }
@@ -0,0 +1,83 @@
+// mute_stats.h
+//
+// Fixed layout of the live statistics page optionally published by the
+// default runner through a memory mapped file (see `--stats=<path>`), and
+// read by the `mute_stats` viewer. Counters are updated with relaxed atomics;
+// the current test and section names are protected by a sequence counter,
+// odd while they are being updated.
+
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// The page is shared with other processes, which requires its atomics to be
+// lock-free rather than guarded by a process local lock.
+static_assert(
+    ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+    "mute_stats_t requires lock-free 32 and 64-bit atomics" );
+
+static const uint32_t mute_stats_magic   = 0x4554554d; // "MUTE"
+static const uint32_t mute_stats_version = 1;
+
+enum mute_stats_state_t : uint32_t {
+    mute_stats_running = 1,
+    mute_stats_done    = 2,
+};
+
+struct mute_stats_t {
+    static const int name_size = 128;
+
+    uint32_t magic;
+    uint32_t version;
+    int64_t  pid;
+    int64_t  start_time_us; // CLOCK_REALTIME
+
+    std::atomic<uint32_t> state;
+    std::atomic<uint32_t> tests_total;
+    std::atomic<uint32_t> tests_run;
+    std::atomic<uint32_t> timeouts;
+    std::atomic<uint64_t> leaves;
+    std::atomic<uint64_t> checks_passed;
+    std::atomic<uint64_t> checks_failed;
+    std::atomic<uint64_t> elapsed_us;
+
+    std::atomic<uint32_t> sequence;
+    char                  current_test[name_size];
+    char                  current_section[name_size];
+
+    // set_names() updates the current test or section names, either of which
+    // can be nullptr to leave it unchanged.
+    void set_names( const char* prefix, const char* test, const char* section_prefix, const char* section ) {
+        sequence.fetch_add( 1, std::memory_order_acq_rel );
+        if ( test ) {
+            snprintf( current_test, name_size, "%s%s", prefix, test );
+        }
+        if ( section ) {
+            snprintf( current_section, name_size, "%s%s", section_prefix, section );
+        }
+        sequence.fetch_add( 1, std::memory_order_release );
+    }
+
+    // read_names() copies the current test and section names, retrying while
+    // they are being updated. It returns false if no consistent copy could be
+    // obtained.
+    bool read_names( char* test, char* section ) const {
+        for ( int i = 0; i < 100; i++ ) {
+            uint32_t seq = sequence.load( std::memory_order_acquire );
+            if ( seq & 1 ) {
+                continue;
+            }
+            memcpy( test, current_test, name_size );
+            memcpy( section, current_section, name_size );
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( sequence.load( std::memory_order_relaxed ) == seq ) {
+                test[name_size - 1]    = 0;
+                section[name_size - 1] = 0;
+                return true;
+            }
+        }
+        return false;
+    }
+};
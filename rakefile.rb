@@ -37,7 +37,7 @@ end
 desc 'Build and run test binaries, updates golden files from output'
 task :'update-gold' do
   system "make test"
-  files = Dir['build/test/**/*.test.output']
+  files = Dir['build/test/**/*.test.output'] + Dir['build/test/**/*.replay.output']
   output_dir = 'test/gold'
   FileUtils.makedirs( output_dir )
   files.each do |f|
@@ -0,0 +1,183 @@
+#!/bin/sh
+#
+# check_runner.sh <build-dir> <mute_stats>
+#
+# Runs the runner_*.test binaries built in <build-dir> with various command
+# line options, checking their output and exit status, and the statistics
+# page they publish as printed by the <mute_stats> viewer. Also feeds inputs
+# to the test_fuzz.fuzz binary built next to the tests, checking the behavior
+# of the default fuzz reporter.
+
+dir=$1
+src=$(dirname "$0")
+mute_stats=$2
+stats=$dir/runner.stats
+failed=0
+
+# run <binary> <args...> runs a test binary, keeping its output in $out and
+# its exit status in $status.
+run() {
+    bin=$dir/$1
+    shift
+    echo "# $bin $*"
+    out=$($bin "$@")
+    status=$?
+}
+
+expect_status() {
+    if [ "$status" != "$1" ]; then
+        echo "FAILED: expected exit status $1, got $status"
+        failed=1
+    fi
+}
+
+expect_output() {
+    if ! printf '%s\n' "$out" | grep -q -e "$1"; then
+        echo "FAILED: expected output matching '$1'"
+        failed=1
+    fi
+}
+
+expect_no_output() {
+    if printf '%s\n' "$out" | grep -q -e "$1"; then
+        echo "FAILED: unexpected output matching '$1'"
+        failed=1
+    fi
+}
+
+run runner_stress.test --test="stress sections" --repeat=8
+expect_status 1
+expect_output "stress: a stable leaf: 8 iterations, 0 failed (0.00%)"
+expect_output "stress: a flaky leaf: 8 iterations, 2 failed (25.00%)"
+expect_output "failed: runs % 4 != 0"
+
+run runner_stress.test --test="stress until failure" --until-failure
+expect_status 1
+expect_output "stress: stress until failure: 4 iterations, 1 failed (25.00%)"
+
+run runner_stress.test --test="stress until failure" --repeat=3
+expect_status 0
+expect_output "stress: stress until failure: 3 iterations, 0 failed (0.00%)"
+expect_no_output "failed:"
+
+run runner_stress.test --test="stress timeout" --repeat=5
+expect_status 124
+expect_output "timeout: a leaf hanging on its third iteration"
+expect_output "stress: a leaf hanging on its third iteration: 3 iterations, 1 failed (33.33%)"
+expect_output "stress: a leaf after the hanging one: 5 iterations, 0 failed (0.00%)"
+
+run runner_stress.test --test="stress first iteration timeout" --repeat=3
+expect_status 124
+expect_output "stress: a leaf hanging on its first iteration: 1 iterations, 1 failed (100.00%)"
+expect_output "stress: a second leaf after the hanging one: 3 iterations, 0 failed (0.00%)"
+expect_output "stress: a third leaf after the hanging one: 3 iterations, 0 failed (0.00%)"
+
+run runner_stress.test --test="stress timeout" --repeat=5 --timeout-exit
+expect_status 124
+expect_output "timeout: a leaf hanging on its third iteration"
+expect_no_output "stress: a leaf"
+
+run runner_timeout.test
+expect_status 124
+expect_output "timeout: a hanging leaf"
+expect_output "timeout: a hanging test"
+expect_no_output "a test after the hanging one"
+
+run runner_timeout.test --timeout-continue
+expect_status 124
+expect_output "timeout: a hanging leaf"
+expect_output "timeout: a hanging test"
+expect_output "enter: a test after the hanging one"
+expect_output "passed: true == true"
+
+run runner_stress.test --test="stress sections" --repeat=8 --quiet
+expect_status 1
+expect_output "stress: a flaky leaf: 8 iterations, 2 failed (25.00%)"
+expect_no_output "enter:"
+expect_no_output "failed:"
+
+run runner_stress.test --test="stress timeout" --repeat=5 --quiet
+expect_status 124
+expect_output "stress: a leaf after the hanging one: 5 iterations, 0 failed (0.00%)"
+expect_no_output "timeout:"
+
+run runner_stress.test --test="a failing check"
+expect_status 1
+expect_output "enter: a leaf with a failed check"
+expect_output "failed: false"
+
+run runner_stress.test --test="a failing check" --quiet
+expect_status 1
+expect_output "failed: false"
+expect_no_output "enter:"
+
+rm -f "$stats"
+run runner_stress.test --test="stress sections" --quiet --stats="$stats"
+expect_status 0
+expect_no_output "."
+echo "# $mute_stats $stats"
+out=$($mute_stats "$stats")
+status=$?
+expect_status 0
+expect_output "^pid: .* (done)$"
+expect_output "^tests: *1 run, 0 remaining$"
+expect_output "^leaves: *2$"
+expect_output "^checks: *2 passed, 0 failed$"
+expect_output "^timeouts: *0$"
+
+rm -f "$stats"
+run runner_stress.test --test="stress timeout" --repeat=5 --quiet --stats="$stats"
+expect_status 124
+echo "# $mute_stats $stats"
+out=$($mute_stats "$stats")
+status=$?
+expect_status 0
+expect_output "^leaves: *8$"
+expect_output "^checks: *7 passed, 0 failed$"
+expect_output "^timeouts: *1$"
+
+rm -f "$stats"
+run runner_timeout.test --quiet --stats="$stats"
+expect_status 124
+echo "# $mute_stats $stats"
+out=$($mute_stats "$stats")
+status=$?
+expect_status 0
+expect_output "^pid: .* (done)$"
+expect_output "^timeouts: *1$"
+
+: >"$stats"
+echo "# $mute_stats $stats (empty)"
+out=$($mute_stats "$stats" 2>&1)
+status=$?
+expect_status 1
+expect_output "not a mute stats file"
+rm -f "$stats"
+
+# fuzz <input> runs the fuzz binary on an input file, keeping its stderr
+# output in $out, its stdout output in $stdout and its exit status in $status.
+fuzz() {
+    echo "# $dir/../test_fuzz.fuzz < $1"
+    out=$("$dir/../test_fuzz.fuzz" <"$1" 2>&1 >"$dir/fuzz.stdout")
+    status=$?
+    stdout=$(cat "$dir/fuzz.stdout")
+    rm -f "$dir/fuzz.stdout"
+}
+
+fuzz "$src/../corpus/test_fuzz/text"
+expect_status 0
+expect_no_output "."
+if [ -n "$stdout" ]; then
+    echo "FAILED: unexpected output on stdout"
+    failed=1
+fi
+
+fuzz "$src/fuzz_crash"
+expect_status 134
+expect_output "failed: !( FUZZ_SIZE == 5 && memcmp( FUZZ_DATA, \"crash\", 5 ) == 0 )"
+
+if [ $failed != 0 ]; then
+    echo "runner checks failed"
+    exit 1
+fi
+echo "runner checks passed"
@@ -0,0 +1,18 @@
+// fuzz_driver.cpp
+//
+// Minimal standalone fuzzing driver, passing the content of stdin to
+// LLVMFuzzerTestOneInput() once, as a fuzzer would. It is linked with tests
+// built against mute_runner_fuzz.h without MUTE_FUZZ_REPLAY, to exercise the
+// default fuzz reporter.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+extern "C" int LLVMFuzzerTestOneInput( const uint8_t* data, size_t size );
+
+int main() {
+    static uint8_t buffer[64 * 1024];
+    size_t         size = fread( buffer, 1, sizeof( buffer ), stdin );
+    return LLVMFuzzerTestOneInput( buffer, size );
+}
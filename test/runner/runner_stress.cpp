@@ -0,0 +1,63 @@
+// runner_stress.cpp
+//
+// Tests exercising the command line options of the default runner, run by
+// check_runner.sh rather than compared to a gold file.
+
+#include "mute/mute.h"
+
+TEST_CASE( "stress sections", "" ) {
+    static int runs = 0;
+
+    SECTION( "a stable leaf" ) {
+        CHECK( runs >= 0 );
+    }
+    SECTION( "a flaky leaf" ) {
+        runs++;
+        CHECK( runs % 4 != 0 );
+    }
+}
+
+TEST_CASE( "stress until failure", "" ) {
+    static int runs = 0;
+    runs++;
+    CHECK( runs % 4 != 0 );
+}
+
+TEST_CASE( "stress timeout", "[timeout=100ms]" ) {
+    static int   runs = 0;
+    volatile int spin = 0;
+
+    SECTION( "a leaf hanging on its third iteration" ) {
+        if ( ++runs == 3 ) {
+            while ( true ) {
+                spin = spin + 1;
+            }
+        }
+        CHECK( spin == 0 );
+    }
+    SECTION( "a leaf after the hanging one" ) {
+        CHECK( spin == 0 );
+    }
+}
+
+TEST_CASE( "stress first iteration timeout", "[timeout=100ms]" ) {
+    volatile int spin = 0;
+
+    SECTION( "a leaf hanging on its first iteration" ) {
+        while ( true ) {
+            spin = spin + 1;
+        }
+    }
+    SECTION( "a second leaf after the hanging one" ) {
+        CHECK( spin == 0 );
+    }
+    SECTION( "a third leaf after the hanging one" ) {
+        CHECK( spin == 0 );
+    }
+}
+
+TEST_CASE( "a failing check", "" ) {
+    SECTION( "a leaf with a failed check" ) {
+        CHECK( false );
+    }
+}
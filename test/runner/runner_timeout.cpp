@@ -0,0 +1,20 @@
+// runner_timeout.cpp
+//
+// Tests exercising the timeout options of the default runner outside stress
+// mode, run by check_runner.sh rather than compared to a gold file.
+
+#include "mute/mute.h"
+
+TEST_CASE( "a hanging test", "[timeout=100ms]" ) {
+    volatile int spin = 0;
+
+    SECTION( "a hanging leaf" ) {
+        while ( true ) {
+            spin = spin + 1;
+        }
+    }
+}
+
+TEST_CASE( "a test after the hanging one", "" ) {
+    CHECK( true );
+}
@@ -0,0 +1,66 @@
+// test_fixtures.cpp
+
+#include "mute/mute.h"
+
+static int table_builds   = 0;
+static int table_destroys = 0;
+
+struct table_t {
+    int values[256];
+    table_t() {
+        table_builds++;
+        for ( int i = 0; i < 256; i++ ) {
+            values[i] = i * i;
+        }
+    }
+    ~table_t() {
+        table_destroys++;
+    }
+};
+
+SUITE_FIXTURE( squares, table_t );
+
+static int fixture_builds = 0;
+
+struct ordered_t {
+    int order = ++fixture_builds;
+};
+
+SUITE_FIXTURE( first, ordered_t );
+SUITE_FIXTURE( second, ordered_t );
+
+SCENARIO( "A fixture is built before the first test using it", "[fixture=squares]" ) {
+    using namespace mute;
+    GIVEN( "a first leaf" ) {
+        CHECK_THAT( FIXTURE( squares ).values[3], eq( 9 ) );
+    }
+    GIVEN( "a second leaf" ) {
+        CHECK_THAT( FIXTURE( squares ).values[12], eq( 144 ) );
+        CHECK_THAT( table_builds, eq( 1 ) );
+    }
+}
+
+SCENARIO( "A fixture is shared by later tests using it", "[aaa,fixture=squares]" ) {
+    using namespace mute;
+    CHECK_THAT( FIXTURE( squares ).values[255], eq( 65025 ) );
+    CHECK_THAT( table_builds, eq( 1 ) );
+}
+
+SCENARIO( "A fixture is torn down after the last test using it", "" ) {
+    using namespace mute;
+    CHECK_THAT( table_builds, eq( 1 ) );
+    CHECK_THAT( table_destroys, eq( 1 ) );
+}
+
+SCENARIO( "A fixture torn down is rebuilt when used again", "" ) {
+    using namespace mute;
+    CHECK_THAT( FIXTURE( squares ).values[7], eq( 49 ) );
+    CHECK_THAT( table_builds, eq( 2 ) );
+    CHECK_THAT( table_destroys, eq( 1 ) );
+}
+
+SCENARIO( "Fixtures are built in declaration order", "[fixture=second,fixture=first]" ) {
+    using namespace mute;
+    CHECK_THAT( FIXTURE( first ).order, eq( 1 ) );
+    CHECK_THAT( FIXTURE( second ).order, eq( 2 ) );
+}
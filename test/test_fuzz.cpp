@@ -0,0 +1,49 @@
+// test_fuzz.cpp
+
+#include "mute/mute.h"
+#include <string>
+
+static std::string hex_encode( const uint8_t* data, size_t size ) {
+    static const char digits[] = "0123456789abcdef";
+    std::string       s;
+    for ( size_t i = 0; i < size; i++ ) {
+        s += digits[data[i] >> 4];
+        s += digits[data[i] & 0xf];
+    }
+    return s;
+}
+
+static std::string hex_decode( const std::string& s ) {
+    std::string bytes;
+    for ( size_t i = 0; i + 1 < s.size(); i += 2 ) {
+        int hi = s[i] <= '9' ? s[i] - '0' : s[i] - 'a' + 10;
+        int lo = s[i + 1] <= '9' ? s[i + 1] - '0' : s[i + 1] - 'a' + 10;
+        bytes += char( hi * 16 + lo );
+    }
+    return bytes;
+}
+
+SCENARIO( "Fuzz tests can access the fuzzer input", "[fuzz]" ) {
+    using namespace mute;
+
+    GIVEN( "any input" ) {
+        THEN( "the input data is available" ) {
+            CHECK( FUZZ_SIZE == 0 || FUZZ_DATA != nullptr );
+        }
+        THEN( "the input survives a hex encoding round-trip" ) {
+            std::string input( FUZZ_SIZE ? (const char*)FUZZ_DATA : "", FUZZ_SIZE );
+            std::string hex = hex_encode( FUZZ_DATA, FUZZ_SIZE );
+            CHECK_THAT( hex.size(), eq( 2 * FUZZ_SIZE ) );
+            CHECK( hex_decode( hex ) == input );
+        }
+        THEN( "the input is not the planted crash input" ) {
+            // Makes the fuzz runner abort on a known input, see
+            // test/runner/fuzz_crash
+            CHECK( !( FUZZ_SIZE == 5 && memcmp( FUZZ_DATA, "crash", 5 ) == 0 ) );
+        }
+    }
+}
+
+SCENARIO( "Tests not tagged fuzz are skipped by the fuzz runner", "" ) {
+    CHECK( FUZZ_SIZE == 0 );
+}
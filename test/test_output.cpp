@@ -0,0 +1,13 @@
+// test_output.cpp
+
+#include "mute/mute.h"
+
+SCENARIO( "Output from the code under test stays in order", "" ) {
+    using namespace mute;
+
+    GIVEN( "a section printing to stdout" ) {
+        printf( "printed from the first section\n" );
+        CHECK( true );
+        printf( "printed after a check\n" );
+    }
+}
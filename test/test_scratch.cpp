@@ -0,0 +1,50 @@
+// test_scratch.cpp
+
+#include "mute/mute.h"
+#include <vector>
+
+SCENARIO( "The scratch arena is reset for each leaf", "" ) {
+    using namespace mute;
+    CHECK_THAT( scratch().used(), eq( 0u ) );
+    char* root = (char*)scratch().allocate( 16 );
+    CHECK( root != nullptr );
+
+    GIVEN( "a first leaf allocating memory" ) {
+        char* p = (char*)scratch().allocate( 100 );
+        CHECK( p == root + 16 );
+        CHECK_THAT( scratch().used(), eq( 116u ) );
+    }
+    GIVEN( "a second leaf allocating memory" ) {
+        char* p = (char*)scratch().allocate( 1000 );
+        CHECK( p == root + 16 );
+        CHECK_THAT( scratch().used(), eq( 1016u ) );
+
+        WHEN( "allocating more in a nested section" ) {
+            scratch().allocate( 10 );
+        }
+        THEN( "memory allocated in the section is released" ) {
+            CHECK_THAT( scratch().used(), eq( 1016u ) );
+        }
+    }
+}
+
+SCENARIO( "The scratch allocator can back STL containers", "" ) {
+    using namespace mute;
+    GIVEN( "a vector using the scratch allocator" ) {
+        std::vector<int, scratch_allocator_t<int>> v;
+        for ( int i = 0; i < 100; i++ ) {
+            v.push_back( i );
+        }
+        CHECK_THAT( v[99], eq( 99 ) );
+        CHECK_THAT( scratch().used(), ge( 400u ) );
+    }
+    GIVEN( "an allocation larger than the arena" ) {
+        CHECK( scratch().allocate( scratch().capacity() + 1 ) == nullptr );
+        CHECK_THAT( scratch().used(), eq( 0u ) );
+    }
+    GIVEN( "an alignment that is not a power of two" ) {
+        CHECK( scratch().allocate( 16, 3 ) == nullptr );
+        CHECK( scratch().allocate( 16, 0 ) == nullptr );
+        CHECK_THAT( scratch().used(), eq( 0u ) );
+    }
+}
@@ -0,0 +1,25 @@
+// test_timeout.cpp
+
+#include "mute/mute.h"
+
+SCENARIO( "A test that hangs is aborted by the watchdog", "[timeout=100ms]" ) {
+    volatile int spin = 0;
+
+    GIVEN( "a section that completes" ) {
+        CHECK( spin == 0 );
+    }
+    GIVEN( "a section that never completes" ) {
+        WHEN( "looping forever" ) {
+            while ( true ) {
+                spin = spin + 1;
+            }
+        }
+    }
+    GIVEN( "a section after the hanging one" ) {
+        CHECK( spin == 0 );
+    }
+}
+
+SCENARIO( "Tests after a timeout are not executed by default", "" ) {
+    CHECK( true );
+}
@@ -0,0 +1,87 @@
+// mute_stats.cpp
+//
+// Viewer for the live statistics page published by the default runner with
+// `--stats=<path>`. It prints a single snapshot of the page and exits, and is
+// meant to be used with `watch`, e.g. `watch -n1 mute_stats run.stats`.
+
+#include "mute/mute_stats.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+int main( int argc, char* argv[] ) {
+    if ( argc != 2 ) {
+        fprintf( stderr, "usage: %s <stats file>\n", argv[0] );
+        return 2;
+    }
+
+    int fd = open( argv[1], O_RDONLY );
+    if ( fd < 0 ) {
+        fprintf( stderr, "%s: cannot open stats file\n", argv[1] );
+        return 1;
+    }
+    // Mapping past the end of the file would fault on access, e.g. while the
+    // runner is still creating it.
+    struct stat st;
+    if ( fstat( fd, &st ) != 0 || st.st_size < off_t( sizeof( mute_stats_t ) ) ) {
+        fprintf( stderr, "%s: not a mute stats file\n", argv[1] );
+        close( fd );
+        return 1;
+    }
+    void* p = mmap( nullptr, sizeof( mute_stats_t ), PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( p == MAP_FAILED ) {
+        fprintf( stderr, "%s: cannot map stats file\n", argv[1] );
+        return 1;
+    }
+
+    const mute_stats_t& stats = *(const mute_stats_t*)p;
+    if ( stats.magic != mute_stats_magic || stats.version != mute_stats_version ) {
+        fprintf( stderr, "%s: not a mute stats file\n", argv[1] );
+        return 1;
+    }
+
+    uint32_t state    = stats.state.load( std::memory_order_acquire );
+    uint32_t total    = stats.tests_total.load( std::memory_order_relaxed );
+    uint32_t run      = stats.tests_run.load( std::memory_order_relaxed );
+    uint32_t timeouts = stats.timeouts.load( std::memory_order_relaxed );
+    uint64_t leaves   = stats.leaves.load( std::memory_order_relaxed );
+    uint64_t passed   = stats.checks_passed.load( std::memory_order_relaxed );
+    uint64_t failed   = stats.checks_failed.load( std::memory_order_relaxed );
+    uint64_t elapsed  = stats.elapsed_us.load( std::memory_order_relaxed );
+    if ( state == mute_stats_running ) {
+        struct timespec ts;
+        clock_gettime( CLOCK_REALTIME, &ts );
+        elapsed = int64_t( ts.tv_sec ) * 1000000 + ts.tv_nsec / 1000 - stats.start_time_us;
+    }
+
+    char test[mute_stats_t::name_size]    = "";
+    char section[mute_stats_t::name_size] = "";
+    stats.read_names( test, section );
+
+    // A runner killed before marking the page as done is reported as such,
+    // with the elapsed time frozen at its last update.
+    const char* status = state == mute_stats_done ? "done" : "running";
+    if ( state != mute_stats_done && kill( pid_t( stats.pid ), 0 ) != 0 && errno == ESRCH ) {
+        status  = "gone";
+        elapsed = stats.elapsed_us.load( std::memory_order_relaxed );
+    }
+
+    printf( "pid:      %lld (%s)\n", (long long)stats.pid, status );
+    printf( "tests:    %u run, %u remaining\n", run, total > run ? total - run : 0 );
+    printf( "leaves:   %llu\n", (unsigned long long)leaves );
+    printf( "checks:   %llu passed, %llu failed\n", (unsigned long long)passed,
+            (unsigned long long)failed );
+    printf( "timeouts: %u\n", timeouts );
+    printf( "elapsed:  %.3f s\n", elapsed / 1e6 );
+    if ( state != mute_stats_done ) {
+        printf( "test:     %s\n", test );
+        printf( "section:  %s\n", section );
+    }
+    return 0;
+}